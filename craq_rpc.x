@@ -51,6 +51,7 @@ struct head_write_arg {
  	rpc_hash chain;
  	rpc_hash id;
 	blob data;
+	unsigned deadline_ms;	/* 0, or how long the client will wait for the reply */
 };
  
 struct propagate_arg {
@@ -59,6 +60,7 @@ struct propagate_arg {
  	unsigned ver;
  	blob data;
  	bool committed;
+ 	unsigned deadline_ms;	/* 0, or ms left before the writer gives up */
 };
  
 struct ack_arg {
@@ -70,6 +72,7 @@ struct ack_arg {
 struct query_obj_ver_arg {
  	rpc_hash chain;
  	rpc_hash id;
+ 	unsigned deadline_ms;	/* 0, or ms left before the reader gives up */
 };
  
 struct query_obj_ver_ret {
@@ -86,12 +89,21 @@ struct tail_read_ex_arg {
  	rpc_hash chain;
  	rpc_hash id;
  	bool dirty;
+ 	unsigned min_ver;	/* 0, or a version returned by a write to read at least */
+ 	unsigned known_ver;	/* 0, or the version the client already holds */
+ 	bool accept_compressed;	/* client can decode value_codec frames */
+ 	unsigned deadline_ms;	/* 0, or how long the client will wait for the reply */
 };
  
 struct tail_read_ex_ret {
  	blob data;
  	bool dirty;
  	unsigned ver;
+ 	bool not_modified;	/* data left empty since client holds ver */
+ 	bool compressed;	/* data is a CODEC_ZLIB value_codec frame */
+ 	unsigned retry_ms;	/* nonzero if the node shed the read; retry after this */
+ 	bool timed_out;	/* deadline passed before the node could answer */
+ 	bool chunked;	/* value too big for one reply; fetch ver with TAIL_READ_CHUNK */
 };
  
 enum add_chain_ret {
@@ -104,6 +116,7 @@ struct add_chain_arg {
  	rpc_hash id;
  	rpc_string data_centers<>;
  	unsigned chain_size;
+ 	unsigned compress_min;	/* 0, or frame values and compress those this big */
 };
 
 struct test_and_set_arg {
@@ -111,23 +124,91 @@ struct test_and_set_arg {
 	rpc_hash id;
 	blob data;
 	unsigned ver;
+	unsigned deadline_ms;	/* 0, or how long the client will wait for the reply */
+};
+
+struct write_ret {
+	bool success;
+	unsigned ver;
+	unsigned retry_ms;	/* nonzero if the node shed the write; retry after this */
+	bool timed_out;	/* deadline passed before the write committed */
+};
+
+struct watch_arg {
+	rpc_hash chain;
+	rpc_hash id;
+	unsigned known_ver;
+	unsigned timeout;	/* milliseconds, 0 for the server maximum */
+};
+
+struct watch_ret {
+	bool changed;
+	unsigned ver;
+	unsigned retry_ms;	/* nonzero if the node has too many watches parked; retry after this */
+};
+
+/* Values over MAX_INLINE_VALUE don't fit one RPC record and are streamed
+ * in CHUNK_SIZE pieces instead. A transfer is named by the key and a
+ * random xfer id picked by its sender */
+const MAX_INLINE_VALUE = 61440;
+const CHUNK_SIZE = 32768;
+
+struct write_chunk_arg {
+	rpc_hash chain;
+	rpc_hash id;
+	unsigned xfer;
+	unsigned offset;
+	unsigned total;
+	blob data;
+	unsigned deadline_ms;
+};
+
+struct propagate_chunk_arg {
+	rpc_hash chain;
+	rpc_hash id;
+	unsigned xfer;
+	unsigned offset;
+	unsigned total;
+	blob data;
+	unsigned ver;	/* 0 for data; otherwise seals the transfer as this version */
+	bool committed;
+	unsigned deadline_ms;
+};
+
+struct read_chunk_arg {
+	rpc_hash chain;
+	rpc_hash id;
+	unsigned ver;
+	unsigned offset;
+};
+
+struct read_chunk_ret {
+	bool ok;	/* false once ver is no longer held; start the read over */
+	unsigned ver;
+	unsigned total;
+	blob data;
+	unsigned retry_ms;	/* nonzero if the node shed the read; retry after this */
 };
  
 program CHAIN_NODE {
 	version CHAIN_NODE_VERSION {
  		/*External functions*/
  		blob TAIL_READ(rpc_hash) = 0;   /* TODO: tail_read_arg */
- 		bool HEAD_WRITE(head_write_arg) = 1;
+ 		write_ret HEAD_WRITE(head_write_arg) = 1;
   		tail_read_ex_ret TAIL_READ_EX(tail_read_ex_arg) = 8;
   		add_chain_ret ADD_CHAIN(add_chain_arg) = 9;
-  		bool TEST_AND_SET(test_and_set_arg) = 10;
+  		write_ret TEST_AND_SET(test_and_set_arg) = 10;
+  		watch_ret WATCH(watch_arg) = 11;
+  		write_ret HEAD_WRITE_CHUNK(write_chunk_arg) = 12;
+  		read_chunk_ret TAIL_READ_CHUNK(read_chunk_arg) = 13;
  		
  		/*Internal functions*/
  		bool PROPAGATE(propagate_arg) = 2;
- 		query_obj_ver_ret QUERY_OBJ_VER(rpc_hash) = 3;  /* TODO: query_obj_ver_arg */
+ 		query_obj_ver_ret QUERY_OBJ_VER(query_obj_ver_arg) = 3;
  		bool ACK(ack_arg) = 4;
  		bool BACK_PROPAGATE(propagate_arg) = 6;
  		bool NO_OP(void) = 7;
+ 		bool PROPAGATE_CHUNK(propagate_chunk_arg) = 14;
 	} = 1;
 } = 21212;
 /* ====================== */